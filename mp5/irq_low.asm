@@ -1,136 +1,169 @@
-global _irq0
-global _irq1
-global _irq2
-global _irq3
-global _irq4
-global _irq5
-global _irq6
-global _irq7
-global _irq8
-global _irq9
-global _irq10
-global _irq11
-global _irq12
-global _irq13
-global _irq14
-global _irq15
-
-; 32: IRQ0
-_irq0:
-    push byte 0
-    push byte 32
-    jmp irq_common_stub
-
-; 33: IRQ1
-_irq1:
-    push byte 0
-    push byte 33
-    jmp irq_common_stub
-
-; 34: IRQ2
-_irq2:
-    push byte 0
-    push byte 34
-    jmp irq_common_stub
-
-; 35: IRQ3
-_irq3:
-    push byte 0
-    push byte 35
-    jmp irq_common_stub
-
-; 36: IRQ4
-_irq4:
-    push byte 0
-    push byte 36
-    jmp irq_common_stub
-
-; 37: IRQ5
-_irq5:
-    push byte 0
-    push byte 37
-    jmp irq_common_stub
-
-; 38: IRQ6
-_irq6:
-    push byte 0
-    push byte 38
-    jmp irq_common_stub
-
-; 39: IRQ7
-_irq7:
-    push byte 0
-    push byte 39
-    jmp irq_common_stub
-
-; 40: IRQ8
-_irq8:
-    push byte 0
-    push byte 40
-    jmp irq_common_stub
-
-; 41: IRQ9
-_irq9:
-    push byte 0
-    push byte 41
-    jmp irq_common_stub
-
-; 42: IRQ10
-_irq10:
-    push byte 0
-    push byte 42
-    jmp irq_common_stub
-
-; 43: IRQ11
-_irq11:
-    push byte 0
-    push byte 43
-    jmp irq_common_stub
-
-; 44: IRQ12
-_irq12:
-    push byte 0
-    push byte 44
-    jmp irq_common_stub
-
-; 45: IRQ13
-_irq13:
-    push byte 0
-    push byte 45
-    jmp irq_common_stub
-
-; 46: IRQ14
-_irq14:
-    push byte 0
-    push byte 46
-    jmp irq_common_stub
-
-; 47: IRQ15
-_irq15:
-    push byte 0
-    push byte 47
-    jmp irq_common_stub
-
-extern _lowlevel_dispatch_interrupt
-
-irq_common_stub:
-    pusha
-    push ds
-    push es
-    push fs
-    push gs
-
-    mov eax, esp
-
-    push eax
-    mov eax, _lowlevel_dispatch_interrupt
-    call eax
-    pop eax
-
-    pop gs
-    pop fs
-    pop es
-    pop ds
-    popa
-    add esp, 8
-    iret
+global _irq0
+global _irq1
+global _irq2
+global _irq3
+global _irq4
+global _irq5
+global _irq6
+global _irq7
+global _irq8
+global _irq9
+global _irq10
+global _irq11
+global _irq12
+global _irq13
+global _irq14
+global _irq15
+global _irq16
+global _irq17
+
+; Each service routine calls its own C-level entry point in 'interrupts.C'
+; ('lowlevel_irq0' to 'lowlevel_irq17') directly. That entry point calls
+; the handler that is bound to the IRQ at compile time, if there is one, 
+; and the interrupt dispatcher otherwise (see 'static_handlers.H').
+%macro IRQ_COMMON 1
+extern %1
+    pusha
+    push ds
+    push es
+    push fs
+    push gs
+
+    mov eax, esp
+
+    push eax
+    call %1
+    pop eax
+
+    pop gs
+    pop fs
+    pop es
+    pop ds
+    popa
+    add esp, 8
+    iret
+%endmacro
+
+; 32: IRQ0
+_irq0:
+    push byte 0
+    push byte 32
+    IRQ_COMMON _lowlevel_irq0
+
+; 33: IRQ1
+_irq1:
+    push byte 0
+    push byte 33
+    IRQ_COMMON _lowlevel_irq1
+
+; 34: IRQ2
+_irq2:
+    push byte 0
+    push byte 34
+    IRQ_COMMON _lowlevel_irq2
+
+; 35: IRQ3
+_irq3:
+    push byte 0
+    push byte 35
+    IRQ_COMMON _lowlevel_irq3
+
+; 36: IRQ4
+_irq4:
+    push byte 0
+    push byte 36
+    IRQ_COMMON _lowlevel_irq4
+
+; 37: IRQ5
+_irq5:
+    push byte 0
+    push byte 37
+    IRQ_COMMON _lowlevel_irq5
+
+; 38: IRQ6
+_irq6:
+    push byte 0
+    push byte 38
+    IRQ_COMMON _lowlevel_irq6
+
+; 39: IRQ7
+_irq7:
+    push byte 0
+    push byte 39
+    IRQ_COMMON _lowlevel_irq7
+
+; 40: IRQ8
+_irq8:
+    push byte 0
+    push byte 40
+    IRQ_COMMON _lowlevel_irq8
+
+; 41: IRQ9
+_irq9:
+    push byte 0
+    push byte 41
+    IRQ_COMMON _lowlevel_irq9
+
+; 42: IRQ10
+_irq10:
+    push byte 0
+    push byte 42
+    IRQ_COMMON _lowlevel_irq10
+
+; 43: IRQ11
+_irq11:
+    push byte 0
+    push byte 43
+    IRQ_COMMON _lowlevel_irq11
+
+; 44: IRQ12
+_irq12:
+    push byte 0
+    push byte 44
+    IRQ_COMMON _lowlevel_irq12
+
+; 45: IRQ13
+_irq13:
+    push byte 0
+    push byte 45
+    IRQ_COMMON _lowlevel_irq13
+
+; 46: IRQ14
+_irq14:
+    push byte 0
+    push byte 46
+    IRQ_COMMON _lowlevel_irq14
+
+; 47: IRQ15
+_irq15:
+    push byte 0
+    push byte 47
+    IRQ_COMMON _lowlevel_irq15
+
+; 48: local APIC timer (at vector 0xF0, see 'lapic_timer.H')
+_irq16:
+    push byte 0
+    push byte 48
+    IRQ_COMMON _lowlevel_irq16
+
+; 49: wake-up IPI (at vector 0xF1, see 'apic.H')
+_irq17:
+    push byte 0
+    push byte 49
+    IRQ_COMMON _lowlevel_irq17
+
+; Spurious interrupts from the local APIC (vector 0xFF). These are not
+; acknowledged with an EOI, so there is nothing to do but count them.
+; The C function may only clobber eax, ecx and edx.
+global _lapic_spurious
+extern _lowlevel_spurious_interrupt
+_lapic_spurious:
+    push eax
+    push ecx
+    push edx
+    cld
+    call _lowlevel_spurious_interrupt
+    pop edx
+    pop ecx
+    pop eax
+    iret
@@ -91,6 +91,62 @@ static_dtors_loop:
 ; Enter an endless loop here in order to stop.
 	jmp $
 
+; ----------------------------------------------------------------------
+; AP TRAMPOLINE
+;
+; The application processors start in real mode, at the 4kB page given
+; in the STARTUP IPI. 'SMP::init' copies the code between _ap_trampoline
+; and _ap_trampoline_end to AP_TRAMPOLINE_BASE (below 1MB), so all
+; addresses inside the trampoline are computed relative to that copy.
+; The trampoline loads a temporary GDT, switches to protected mode, picks
+; up the stack that the BSP prepared in '_ap_boot_stack', and calls
+; 'ap_main' (in smp.C), which loads the per-CPU GDT and the IDT.
+; ----------------------------------------------------------------------
+
+AP_TRAMPOLINE_BASE equ 0x8000	; must match SMP::TRAMPOLINE_ADDRESS
+%define AP_REL(addr) (AP_TRAMPOLINE_BASE + ((addr) - _ap_trampoline))
+
+global _ap_trampoline
+global _ap_trampoline_end
+extern _ap_boot_stack
+extern _ap_main
+
+[BITS 16]
+ALIGN 16
+_ap_trampoline:
+	cli
+	cld
+	xor ax, ax
+	mov ds, ax
+	o32 lgdt [AP_REL(ap_gdt_ptr)]
+	mov eax, cr0
+	or eax, 1		; set PE (protection enable)
+	mov cr0, eax
+	jmp dword 0x08:AP_REL(ap_protected_mode)
+
+[BITS 32]
+ap_protected_mode:
+	mov ax, 0x10
+	mov ds, ax
+	mov es, ax
+	mov fs, ax
+	mov gs, ax
+	mov ss, ax
+	mov esp, [_ap_boot_stack]
+	mov eax, _ap_main	; absolute call, we are running from the copy
+	call eax
+	jmp $
+
+ALIGN 8
+ap_gdt:			; null, code and data segment, as in gdt.C
+	dq 0x0000000000000000
+	dq 0x00CF9A000000FFFF
+	dq 0x00CF92000000FFFF
+ap_gdt_ptr:
+	dw ap_gdt_ptr - ap_gdt - 1
+	dd AP_REL(ap_gdt)
+_ap_trampoline_end:
+
 ; Set up Global Descriptor Table
 %include "gdt_low.asm"
 
@@ -21,6 +21,14 @@
 KERNEL_CS equ 1<<3	; kernel code segment is GDT entry 1
 KERNEL_DS equ 2<<3	; kernel data segment is GDT entry 2
 
+CPU_CURRENT_THREAD equ 4	; offset of 'current_thread' in class CPU;
+				; the per-CPU data is reached through fs
+CPU_TLS_DESCRIPTOR equ 8	; offset of 'tls_descriptor' in class CPU
+
+THREAD_ESP    equ 0	; offset of 'esp' in class Thread
+THREAD_ON_CPU equ 4	; offset of 'on_cpu' in class Thread
+THREAD_TLS    equ 8	; offset of 'tls' in class Thread
+
 
 INTERRUPT_STATE_SIZE equ 68 ; size of exception frame on stack
 
@@ -36,6 +44,19 @@ INTERRUPT_STATE_SIZE equ 68 ; size of exception frame on stack
 	push	gs
 %endmacro
 
+; Point the TLS segment in the GDT of this CPU at the TLS block of the
+; new thread, whose pointer is in eax. The new base takes effect when gs
+; is reloaded by restore_registers. Clobbers ebx and ecx, which are
+; restored from the context of the new thread as well.
+%macro load_tls 0
+	mov	ecx, [eax+THREAD_TLS]
+	mov	ebx, [fs:CPU_TLS_DESCRIPTOR]
+	mov	[ebx+2], cx	; base bits 0-15
+	shr	ecx, 16
+	mov	[ebx+4], cl	; base bits 16-23
+	mov	[ebx+7], ch	; base bits 24-31
+%endmacro
+
 ; Restore registers and clean up the stack after calling a handler function
 ; (i.e., just before we return from the interrupt via an iret instruction).
 %macro restore_registers 0
@@ -47,9 +68,6 @@ INTERRUPT_STATE_SIZE equ 68 ; size of exception frame on stack
 	add	esp, 8	; skip int num and error code
 %endmacro
 
-extern _current_thread  ; defined and initialized in threads.c
-
-
 global _threads_low_switch_to
 align 16
 ; this function is exported.
@@ -61,7 +79,7 @@ _threads_low_switch_to:
 	; don't need to do anything with setting up and saving the current
         ; context. We simply proceed to loading the new context. 
 
-	cmp	[_current_thread], dword 0
+	cmp	[fs:CPU_CURRENT_THREAD], dword 0
 	je	.context_load_only
 
 	; Modify the stack to allow a later return via an iret instruction.
@@ -95,8 +113,9 @@ _threads_low_switch_to:
 	save_registers
 
 	; Save stack pointer in the thread context struct (at offset 0).
-	mov	eax, [_current_thread]
-	mov	[eax+0], esp
+	; Keep the pointer to the old thread in edx.
+	mov	edx, [fs:CPU_CURRENT_THREAD]
+	mov	[edx+THREAD_ESP], esp
 
 	; Load the pointer to the new thread context into eax.
 	; We skip over the Interrupt_State struct on the stack to
@@ -104,8 +123,15 @@ _threads_low_switch_to:
 	mov	eax, dword [esp+INTERRUPT_STATE_SIZE]
 
 	; Make the new thread current, and switch to its stack.
-	mov	[_current_thread], eax
-	mov	esp, [eax+0]
+	mov	[fs:CPU_CURRENT_THREAD], eax
+	mov	esp, [eax+THREAD_ESP]
+
+	; We are off the stack of the old thread, and its context is saved.
+	; Only now may another CPU dispatch it (see Thread::dispatch_to).
+	mov	dword [edx+THREAD_ON_CPU], 0
+
+	; Switch the thread-local storage.
+	load_tls
 
 	; Restore general purpose and segment registers, and clear interrupt
 	; number and error code.
@@ -122,8 +148,11 @@ _threads_low_switch_to:
         mov	eax, [esp+4]
 
 	; Make the new thread current, and switch to its stack.
-	mov	[_current_thread], eax
-	mov	esp, [eax+0]
+	mov	[fs:CPU_CURRENT_THREAD], eax
+	mov	esp, [eax+THREAD_ESP]
+
+	; Switch the thread-local storage.
+	load_tls
 
 	; Restore general purpose and segment registers, and clear interrupt
 	; number and error code.